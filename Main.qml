@@ -10,6 +10,10 @@ Window {
     visible: true
     title: qsTr("Tri State Switch")
 
+    QualityGovernor {
+        window: root
+    }
+
     function prevCheckState(checkState: int): int {
         switch (checkState) {
         default:
@@ -38,9 +42,11 @@ Window {
         y: 20
         text: "Randomize"
         onClicked: {
-            for (const triStateSwitch of [triState, triState1, triState2]) {
-                triStateSwitch.corners = GeometryUtils.randomUnitTriangle();
-            }
+            TriStateSwitchBatch.run(() => {
+                for (const triStateSwitch of [triState, triState1, triState2]) {
+                    triStateSwitch.corners = GeometryUtils.randomUnitTriangle();
+                }
+            });
         }
     }
 
@@ -8,30 +8,12 @@ Item {
 
     required property TriStateSwitch control
 
-    readonly property point position: Qt.point(positionX, positionY)
-    property real positionX: control.position.x
-    property real positionY: control.position.y
-
-    NumberBehavior on positionX {}
-    NumberBehavior on positionY {}
-
-    readonly property point positionUnchecked: root.control.corners[0]
-    readonly property point positionPartiallyChecked: root.control.corners[1]
-    readonly property point positionChecked: root.control.corners[2]
-
-    // transitions in normalized coordinates:
-    // x corresponds to the position between the specified states,
-    // y corresponds to the perpendicular position between the third state and a line between these two.
-    readonly property point positionUncheckedToChecked: GeometryUtils.planarPosition(positionUnchecked, positionChecked, positionPartiallyChecked, position)
-    readonly property point positionUncheckedToPartiallyChecked: GeometryUtils.planarPosition(positionUnchecked, positionPartiallyChecked, positionChecked, position)
-    readonly property point positionPartiallyCheckedToChecked: GeometryUtils.planarPosition(positionPartiallyChecked, positionChecked, positionUnchecked, position)
-
-    readonly property real positionOfChecked: 1 - positionUncheckedToPartiallyChecked.y
-    readonly property real positionOfPartiallyChecked: 1 - positionUncheckedToChecked.y
-    readonly property real positionOfUnchecked: 1 - positionPartiallyCheckedToChecked.y
-
     readonly property real knobSize: 28
 
+    // degraded by the QualityGovernor of the window under frame-budget pressure
+    readonly property int qualityTier: QualityGovernor.tier
+    readonly property bool animated: !root.control.pressed && root.qualityTier < QualityGovernor.NoAnimation
+
     implicitWidth: 70
     implicitHeight: 50
 
@@ -53,15 +35,21 @@ Item {
 
             PathSvg {
                 path: {
-                    const vertices = GeometryUtils.scaledPoints(root.control.corners, Qt.size(shape.width, shape.height));
-                    return GeometryUtils.roundedTriangleOutlineSvgPath(...vertices, knobSize / 2);
+                    const corners = GeometryUtils.scaledCorners(root.control.corners, Qt.size(shape.width, shape.height));
+                    return GeometryUtils.roundedTriangleOutlineSvgPath(corners, root.knobSize / 2);
                 }
             }
         }
 
-        layer.enabled: true
+        layer.enabled: root.qualityTier < QualityGovernor.NoMultisampling
         layer.samples: 4
-        layer.effect: MultiEffect {
+        layer.effect: root.qualityTier < QualityGovernor.NoShadow ? shadowEffect : null
+    }
+
+    Component {
+        id: shadowEffect
+
+        MultiEffect {
             shadowEnabled: true
             shadowBlur: 0.2
             shadowColor: root.control.palette.shadow
@@ -93,53 +81,23 @@ Item {
             border.color: root.control.visualFocus ? root.control.palette.highlight : root.control.palette.mid
             radius: width / 2
 
-            // icon canvas
-            Item {
+            // icon: minus, ellipsis and plus signs, morphing between each other
+            TriStateSwitchKnobIcon {
                 // that makes it 16x16
                 anchors.fill: parent
                 anchors.margins: 4
 
-                // horizontal line for Unchecked minus sign & Checked plus sign,
-                // collapses into a middle dot for PartiallyChecked (...)
-                Line {
-                    anchors.centerIn: parent
-                    width: GeometryUtils.lerp(parent.width, implicitWidth, root.positionOfPartiallyChecked)
-                }
-
-                // vertical line for Checked plus sign
-                // collapses into a middle dot for Unchecked & PartiallyChecked (...)
-                Line {
-                    anchors.centerIn: parent
-                    height: GeometryUtils.lerp(implicitHeight, parent.height, root.positionOfChecked)
-                }
-
-                // left dot for PartiallyChecked (...)
-                Line {
-                    anchors.left: parent.left
-                    anchors.verticalCenter: parent.verticalCenter
-                    opacity: root.positionOfPartiallyChecked
-                }
-
-                // right dot for PartiallyChecked (...)
-                Line {
-                    anchors.right: parent.right
-                    anchors.verticalCenter: parent.verticalCenter
-                    opacity: root.positionOfPartiallyChecked
-                }
+                // eased natively, binding to the animated knob position would evaluate it on every tick
+                position: root.control.position
+                animated: root.animated
+                corners: root.control.corners
+                color: root.control.palette.dark
             }
         }
     }
 
-    component Line : Rectangle {
-        anchors.alignWhenCentered: false
-        implicitWidth: 4
-        implicitHeight: 4
-        color: root.control.palette.dark
-        radius: Math.min(width, height)
-    }
-
     component NumberBehavior : Behavior {
-        enabled: !root.control.pressed
+        enabled: root.animated
         NumberAnimation {
             duration: 500
             easing.type: Easing.OutCubic
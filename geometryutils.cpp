@@ -3,6 +3,7 @@
 #include <QStringBuilder>
 
 #include <algorithm>
+#include <array>
 #include <optional>
 #include <random>
 
@@ -143,6 +144,11 @@ QPointF GeometryUtils::snapPointToTriangle(QPointF vertexA, QPointF vertexB, QPo
     return snapVectorToTriangle(QVector2D(vertexA), QVector2D(vertexB), QVector2D(vertexC), QVector2D(position)).toPointF();
 }
 
+QPointF GeometryUtils::snapPointToTriangle(const TriStateCorners &corners, QPointF position)
+{
+    return snapPointToTriangle(corners.unchecked(), corners.partiallyChecked(), corners.checked(), position);
+}
+
 QVector2D GeometryUtils::snapVectorToTriangle(QVector2D vertexA, QVector2D vertexB, QVector2D vertexC, QVector2D position)
 {
     if (isPositionInsideTriangle(vertexA, vertexB, vertexC, position)) {
@@ -159,7 +165,7 @@ QVector2D GeometryUtils::snapVectorToTriangle(QVector2D vertexA, QVector2D verte
     return bestSnapCandidate.target;
 }
 
-QList<QPointF> GeometryUtils::randomUnitTriangle()
+TriStateCorners GeometryUtils::randomUnitTriangle()
 {
     constexpr const unsigned int NUM_VERTICES = 3;
 
@@ -199,7 +205,7 @@ QList<QPointF> GeometryUtils::randomUnitTriangle()
         return point;
     };
 
-    QList<QPointF> vertices{NUM_VERTICES};
+    std::array<QPointF, NUM_VERTICES> vertices;
 
     // Random shape:
     // 0. Two on the same edge, third needs to be on the opposite edge.
@@ -240,7 +246,7 @@ QList<QPointF> GeometryUtils::randomUnitTriangle()
 
     // random swap vertices
     std::shuffle(vertices.begin(), vertices.end(), rng);
-    return vertices;
+    return TriStateCorners(vertices[0], vertices[1], vertices[2]);
 }
 
 namespace
@@ -323,6 +329,11 @@ QString GeometryUtils::roundedTriangleOutlineSvgPath(QPointF vertexA, QPointF ve
     return svg;
 }
 
+QString GeometryUtils::roundedTriangleOutlineSvgPath(const TriStateCorners &corners, qreal cornerRadius)
+{
+    return roundedTriangleOutlineSvgPath(corners.unchecked(), corners.partiallyChecked(), corners.checked(), cornerRadius);
+}
+
 QList<QPointF> GeometryUtils::scaledPoints(const QList<QPointF> &points, QSizeF scale)
 {
     QList<QPointF> scaled = points;
@@ -332,4 +343,12 @@ QList<QPointF> GeometryUtils::scaledPoints(const QList<QPointF> &points, QSizeF
     return scaled;
 }
 
+TriStateCorners GeometryUtils::scaledCorners(const TriStateCorners &corners, QSizeF scale)
+{
+    auto scaled = [scale](QPointF point) -> QPointF {
+        return QPointF(point.x() * scale.width(), point.y() * scale.height());
+    };
+    return TriStateCorners(scaled(corners.unchecked()), scaled(corners.partiallyChecked()), scaled(corners.checked()));
+}
+
 #include "moc_geometryutils.cpp"
@@ -6,6 +6,8 @@
 #include <QPoint>
 #include <QVector2D>
 
+#include "tristatecorners.h"
+
 class GeometryUtils : public QObject
 {
     Q_OBJECT
@@ -31,17 +33,20 @@ public:
     // Otherwise, find the closest vertex or a perpendicular projection on the perimeter.
     Q_INVOKABLE static QPointF snapPointToTriangle(QPointF vertexA, QPointF vertexB, QPointF vertexC, QPointF position);
     Q_INVOKABLE static QVector2D snapVectorToTriangle(QVector2D vertexA, QVector2D vertexB, QVector2D vertexC, QVector2D position);
+    Q_INVOKABLE static QPointF snapPointToTriangle(const TriStateCorners &corners, QPointF position);
 
     // Generate a random triangle (three vertices) whose bounds are a unit square.
-    Q_INVOKABLE static QList<QPointF> randomUnitTriangle();
+    Q_INVOKABLE static TriStateCorners randomUnitTriangle();
 
     // Generate an SVG path for an outline of a triangle with rounded corners.
     // Vertices are centers of circles for the rounded corners,
     // so the all edges are offset outward by the radius.
     Q_INVOKABLE static QString roundedTriangleOutlineSvgPath(QPointF vertexA, QPointF vertexB, QPointF vertexC, qreal cornerRadius);
+    Q_INVOKABLE static QString roundedTriangleOutlineSvgPath(const TriStateCorners &corners, qreal cornerRadius);
 
     // Multiply each point by the given scale factor.
     Q_INVOKABLE static QList<QPointF> scaledPoints(const QList<QPointF> &points, QSizeF scale);
+    Q_INVOKABLE static TriStateCorners scaledCorners(const TriStateCorners &corners, QSizeF scale);
 };
 
 #endif // GEOMETRYUTILS_H
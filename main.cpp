@@ -1,11 +1,37 @@
+#include <QCommandLineParser>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
+#include <QQuickWindow>
+#include <QTextStream>
+#include <QTimer>
+
+#include "pointertrace.h"
+
+using namespace Qt::StringLiterals;
 
 int main(int argc, char *argv[])
 {
     qputenv("QT_SCALE_FACTOR", "1.0");
     QGuiApplication app(argc, argv);
 
+    // Pointer traces make interaction profiling reproducible:
+    //   record:  appTriStateSwitchQt --record-trace drag.trace
+    //   replay:  appTriStateSwitchQt -platform offscreen --replay-trace drag.trace --replay-speed 0
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    const QCommandLineOption recordOption(u"record-trace"_s, u"Record pointer events delivered to the switches into <file>."_s, u"file"_s);
+    const QCommandLineOption replayOption(u"replay-trace"_s, u"Replay pointer events from <file>, report handling times and quit."_s, u"file"_s);
+    const QCommandLineOption speedOption(u"replay-speed"_s, u"Replay speed factor, 0 replays as fast as possible (default: 1)."_s, u"factor"_s, u"1"_s);
+    parser.addOptions({recordOption, replayOption, speedOption});
+    parser.process(app);
+
+    bool speedOk = false;
+    const qreal speed = parser.value(speedOption).toDouble(&speedOk);
+    if (!speedOk || speed < 0.0) {
+        qCritical() << "Invalid replay speed factor:" << parser.value(speedOption);
+        return 1;
+    }
+
     QQmlApplicationEngine engine;
     QObject::connect(
         &engine,
@@ -15,5 +41,35 @@ int main(int argc, char *argv[])
         Qt::QueuedConnection);
     engine.loadFromModule("TriStateSwitchQt", "Main");
 
+    auto window = qobject_cast<QQuickWindow *>(engine.rootObjects().value(0));
+
+    if (parser.isSet(replayOption) && window) {
+        PointerTrace trace;
+        QString error;
+        if (!trace.load(parser.value(replayOption), &error)) {
+            qCritical() << "Failed to load pointer trace:" << error;
+            return 1;
+        }
+        auto replayer = new PointerTraceReplayer(window, &app);
+        replayer->setTrace(trace);
+        replayer->setSpeed(speed);
+        QObject::connect(replayer, &PointerTraceReplayer::finished, &app, [replayer]() {
+            QTextStream out(stdout);
+            replayer->writeReport(out);
+            out.flush();
+            QCoreApplication::exit(replayer->matchesRecording() ? 0 : 2);
+        });
+        QTimer::singleShot(0, replayer, &PointerTraceReplayer::start);
+    } else if (parser.isSet(recordOption) && window) {
+        auto recorder = new PointerTraceRecorder(window, &app);
+        recorder->start();
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, recorder, [recorder, fileName = parser.value(recordOption)]() {
+            QString error;
+            if (!recorder->save(fileName, &error)) {
+                qCritical() << "Failed to save pointer trace:" << error;
+            }
+        });
+    }
+
     return app.exec();
 }
@@ -0,0 +1,572 @@
+#include "pointertrace.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtimer.h>
+#include <QtGui/qevent.h>
+#include <QtGui/qpointingdevice.h>
+#include <QtGui/private/qeventpoint_p.h>
+
+#include <algorithm>
+#include <optional>
+
+#include "tristateswitch.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+
+constexpr quint32 TRACE_MAGIC = 0x54535054; // "TSPT"
+constexpr quint16 TRACE_VERSION = 2;
+
+constexpr qreal POSITION_TOLERANCE = 1e-3;
+
+void setError(QString *errorString, const QString &message)
+{
+    if (errorString) {
+        *errorString = message;
+    }
+}
+
+std::optional<PointerTrace::EventType> traceEventType(QEvent::Type type)
+{
+    switch (type) {
+    case QEvent::MouseButtonPress:
+        return PointerTrace::EventType::MousePress;
+    case QEvent::MouseMove:
+        return PointerTrace::EventType::MouseMove;
+    case QEvent::MouseButtonRelease:
+        return PointerTrace::EventType::MouseRelease;
+    case QEvent::MouseButtonDblClick:
+        return PointerTrace::EventType::MouseDoubleClick;
+    case QEvent::TouchBegin:
+        return PointerTrace::EventType::TouchBegin;
+    case QEvent::TouchUpdate:
+        return PointerTrace::EventType::TouchUpdate;
+    case QEvent::TouchEnd:
+        return PointerTrace::EventType::TouchEnd;
+    case QEvent::TouchCancel:
+        return PointerTrace::EventType::TouchCancel;
+    default:
+        return {};
+    }
+}
+
+QEvent::Type qtEventType(PointerTrace::EventType type)
+{
+    switch (type) {
+    case PointerTrace::EventType::MousePress:
+        return QEvent::MouseButtonPress;
+    case PointerTrace::EventType::MouseMove:
+    default:
+        return QEvent::MouseMove;
+    case PointerTrace::EventType::MouseRelease:
+        return QEvent::MouseButtonRelease;
+    case PointerTrace::EventType::MouseDoubleClick:
+        return QEvent::MouseButtonDblClick;
+    case PointerTrace::EventType::TouchBegin:
+        return QEvent::TouchBegin;
+    case PointerTrace::EventType::TouchUpdate:
+        return QEvent::TouchUpdate;
+    case PointerTrace::EventType::TouchEnd:
+        return QEvent::TouchEnd;
+    case PointerTrace::EventType::TouchCancel:
+        return QEvent::TouchCancel;
+    }
+}
+
+bool isClose(QPointF a, QPointF b)
+{
+    return qAbs(a.x() - b.x()) <= POSITION_TOLERANCE && qAbs(a.y() - b.y()) <= POSITION_TOLERANCE;
+}
+
+void writePoint(QDataStream &stream, QPointF point)
+{
+    stream << point.x() << point.y();
+}
+
+QPointF readPoint(QDataStream &stream)
+{
+    qreal x = 0.0, y = 0.0;
+    stream >> x >> y;
+    return {x, y};
+}
+
+void writeStates(QDataStream &stream, const QList<PointerTrace::SwitchState> &states)
+{
+    stream << quint16(states.size());
+    for (const PointerTrace::SwitchState &state : states) {
+        stream << quint8(state.checkState);
+        writePoint(stream, state.position);
+        for (const QPointF corner : state.corners.points()) {
+            writePoint(stream, corner);
+        }
+    }
+}
+
+QList<PointerTrace::SwitchState> readStates(QDataStream &stream)
+{
+    QList<PointerTrace::SwitchState> states;
+    quint16 switchCount = 0;
+    stream >> switchCount;
+    states.reserve(switchCount);
+    for (quint16 i = 0; i < switchCount && stream.status() == QDataStream::Ok; i++) {
+        PointerTrace::SwitchState state;
+        quint8 checkState = 0;
+        stream >> checkState;
+        state.checkState = static_cast<Qt::CheckState>(checkState);
+        state.position = readPoint(stream);
+        const QPointF unchecked = readPoint(stream);
+        const QPointF partiallyChecked = readPoint(stream);
+        const QPointF checked = readPoint(stream);
+        state.corners = TriStateCorners(unchecked, partiallyChecked, checked);
+        states.append(state);
+    }
+    return states;
+}
+
+void writeState(QTextStream &stream, const PointerTrace::SwitchState &state)
+{
+    stream << state.checkState << '\t' << state.position.x() << ',' << state.position.y() << '\t' << state.corners.toString();
+}
+
+void collectSwitches(QQuickItem *item, QList<TriStateSwitch *> &switches)
+{
+    if (auto control = qobject_cast<TriStateSwitch *>(item)) {
+        switches.append(control);
+        // switches are not supposed to be nested
+        return;
+    }
+    const auto children = item->childItems();
+    for (QQuickItem *child : children) {
+        collectSwitches(child, switches);
+    }
+}
+
+QList<QPointer<TriStateSwitch>> trackedSwitchesIn(QQuickWindow *window)
+{
+    const QList<TriStateSwitch *> switches = PointerTrace::switchesIn(window);
+    return {switches.cbegin(), switches.cend()};
+}
+
+}
+
+bool PointerTrace::SwitchState::operator==(const SwitchState &other) const
+{
+    // states go through single precision when saved
+    return checkState == other.checkState
+        && isClose(position, other.position)
+        && isClose(corners.unchecked(), other.corners.unchecked())
+        && isClose(corners.partiallyChecked(), other.corners.partiallyChecked())
+        && isClose(corners.checked(), other.corners.checked());
+}
+
+bool PointerTrace::load(const QString &fileName, QString *errorString)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    stream >> magic >> version;
+    if (magic != TRACE_MAGIC || version != TRACE_VERSION) {
+        setError(errorString, u"Not a pointer trace, or unsupported version"_s);
+        return false;
+    }
+
+    const QList<SwitchState> recordedInitialStates = readStates(stream);
+    const QList<SwitchState> recordedFinalStates = readStates(stream);
+
+    QList<Event> trace;
+    quint32 eventCount = 0;
+    stream >> eventCount;
+    for (quint32 i = 0; i < eventCount && stream.status() == QDataStream::Ok; i++) {
+        Event event;
+        quint8 type = 0;
+        stream >> event.timestamp >> event.target >> type;
+        if (type > quint8(EventType::TouchCancel)) {
+            setError(errorString, u"Unknown event type %1"_s.arg(int(type)));
+            return false;
+        }
+        event.type = static_cast<EventType>(type);
+        if (isMouseEvent(event.type)) {
+            stream >> event.button >> event.buttons;
+            event.position = readPoint(stream);
+        } else {
+            quint8 pointCount = 0;
+            stream >> pointCount;
+            event.points.reserve(pointCount);
+            for (quint8 p = 0; p < pointCount; p++) {
+                TouchPoint point;
+                stream >> point.id >> point.state;
+                point.position = readPoint(stream);
+                event.points.append(point);
+            }
+        }
+        trace.append(event);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        setError(errorString, u"Truncated pointer trace"_s);
+        return false;
+    }
+
+    initialStates = recordedInitialStates;
+    finalStates = recordedFinalStates;
+    events = trace;
+    return true;
+}
+
+bool PointerTrace::save(const QString &fileName, QString *errorString) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    // positions are normalized or in item coordinates, single precision is plenty.
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    stream << TRACE_MAGIC << TRACE_VERSION;
+
+    writeStates(stream, initialStates);
+    writeStates(stream, finalStates);
+
+    stream << quint32(events.size());
+    for (const Event &event : events) {
+        stream << event.timestamp << event.target << quint8(event.type);
+        if (isMouseEvent(event.type)) {
+            stream << event.button << event.buttons;
+            writePoint(stream, event.position);
+        } else {
+            stream << quint8(event.points.size());
+            for (const TouchPoint &point : event.points) {
+                stream << point.id << point.state;
+                writePoint(stream, point.position);
+            }
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool PointerTrace::isMouseEvent(EventType type)
+{
+    return type == EventType::MousePress || type == EventType::MouseMove || type == EventType::MouseRelease
+        || type == EventType::MouseDoubleClick;
+}
+
+const char *PointerTrace::eventTypeName(EventType type)
+{
+    switch (type) {
+    case EventType::MousePress:
+        return "MousePress";
+    case EventType::MouseMove:
+        return "MouseMove";
+    case EventType::MouseRelease:
+        return "MouseRelease";
+    case EventType::MouseDoubleClick:
+        return "MouseDoubleClick";
+    case EventType::TouchBegin:
+        return "TouchBegin";
+    case EventType::TouchUpdate:
+        return "TouchUpdate";
+    case EventType::TouchEnd:
+        return "TouchEnd";
+    case EventType::TouchCancel:
+        return "TouchCancel";
+    }
+    return "Unknown";
+}
+
+QList<TriStateSwitch *> PointerTrace::switchesIn(QQuickWindow *window)
+{
+    QList<TriStateSwitch *> switches;
+    if (window) {
+        collectSwitches(window->contentItem(), switches);
+    }
+    return switches;
+}
+
+PointerTrace::SwitchState PointerTrace::stateOf(const TriStateSwitch *control)
+{
+    if (!control) {
+        return {};
+    }
+    return {control->checkState(), control->position(), control->corners()};
+}
+
+void PointerTrace::restoreState(TriStateSwitch *control, const SwitchState &state)
+{
+    control->setCorners(state.corners);
+    control->setCheckState(state.checkState);
+    control->setPosition(state.position);
+}
+
+PointerTraceRecorder::PointerTraceRecorder(QQuickWindow *window, QObject *parent)
+    : QObject{parent}
+    , m_window(window)
+{
+}
+
+void PointerTraceRecorder::start()
+{
+    stop();
+    m_trace = {};
+    m_switches = trackedSwitchesIn(m_window);
+    for (TriStateSwitch *control : std::as_const(m_switches)) {
+        m_trace.initialStates.append(PointerTrace::stateOf(control));
+        control->installEventFilter(this);
+    }
+    m_clock.start();
+}
+
+void PointerTraceRecorder::stop()
+{
+    for (TriStateSwitch *control : std::as_const(m_switches)) {
+        if (control) {
+            control->removeEventFilter(this);
+        }
+    }
+}
+
+bool PointerTraceRecorder::save(const QString &fileName, QString *errorString)
+{
+    stop();
+    m_trace.finalStates.clear();
+    for (const TriStateSwitch *control : std::as_const(m_switches)) {
+        m_trace.finalStates.append(PointerTrace::stateOf(control));
+    }
+    return m_trace.save(fileName, errorString);
+}
+
+bool PointerTraceRecorder::eventFilter(QObject *watched, QEvent *event)
+{
+    const auto type = traceEventType(event->type());
+    if (!type.has_value()) {
+        return false;
+    }
+    const qsizetype target = m_switches.indexOf(qobject_cast<TriStateSwitch *>(watched));
+    if (target < 0) {
+        return false;
+    }
+
+    // events reach the filter already localized to the item coordinates of the switch
+    if (PointerTrace::isMouseEvent(*type)) {
+        recordMouseEvent(quint16(target), *type, static_cast<QMouseEvent *>(event));
+    } else {
+        recordTouchEvent(quint16(target), *type, static_cast<QTouchEvent *>(event));
+    }
+    return false;
+}
+
+void PointerTraceRecorder::recordMouseEvent(quint16 target, PointerTrace::EventType type, const QMouseEvent *event)
+{
+    PointerTrace::Event record;
+    record.timestamp = quint32(m_clock.elapsed());
+    record.target = target;
+    record.type = type;
+    record.button = quint8(event->button());
+    record.buttons = quint8(event->buttons().toInt());
+    record.position = event->position();
+    m_trace.events.append(record);
+}
+
+void PointerTraceRecorder::recordTouchEvent(quint16 target, PointerTrace::EventType type, const QTouchEvent *event)
+{
+    PointerTrace::Event record;
+    record.timestamp = quint32(m_clock.elapsed());
+    record.target = target;
+    record.type = type;
+    for (const QEventPoint &point : event->points()) {
+        record.points.append({quint16(point.id()), quint8(point.state()), point.position()});
+    }
+    m_trace.events.append(record);
+}
+
+PointerTraceReplayer::PointerTraceReplayer(QQuickWindow *window, QObject *parent)
+    : QObject{parent}
+    , m_window(window)
+    , m_touchDevice(new QPointingDevice(u"TriStateSwitch pointer trace"_s, 0x7e57,
+                                        QInputDevice::DeviceType::TouchScreen, QPointingDevice::PointerType::Finger,
+                                        QInputDevice::Capability::Position, 10, 0,
+                                        QString(), QPointingDeviceUniqueId(), this))
+{
+}
+
+void PointerTraceReplayer::setTrace(const PointerTrace &trace)
+{
+    m_trace = trace;
+}
+
+qreal PointerTraceReplayer::speed() const
+{
+    return m_speed;
+}
+
+void PointerTraceReplayer::setSpeed(qreal speed)
+{
+    m_speed = speed;
+}
+
+void PointerTraceReplayer::start()
+{
+    m_switches = trackedSwitchesIn(m_window);
+
+    // the switches may have been changed by other means before or during the recording,
+    // e.g. by randomizing corners. Start from the same place, so that only the replayed
+    // events are responsible for the final states.
+    for (qsizetype i = 0; i < m_switches.size() && i < m_trace.initialStates.size(); i++) {
+        PointerTrace::restoreState(m_switches[i], m_trace.initialStates[i]);
+    }
+    // restoring a switch may affect others through bindings, so check only after all of them
+    m_restoredInitialStates = m_switches.size() == m_trace.initialStates.size();
+    for (qsizetype i = 0; i < m_switches.size() && m_restoredInitialStates; i++) {
+        m_restoredInitialStates = PointerTrace::stateOf(m_switches[i]) == m_trace.initialStates[i];
+    }
+
+    m_samples.clear();
+    m_samples.reserve(m_trace.events.size());
+    m_finalStates.clear();
+    m_next = 0;
+    m_clock.start();
+    scheduleNext();
+}
+
+void PointerTraceReplayer::scheduleNext()
+{
+    if (m_next >= m_trace.events.size()) {
+        for (const TriStateSwitch *control : std::as_const(m_switches)) {
+            m_finalStates.append(PointerTrace::stateOf(control));
+        }
+        Q_EMIT finished();
+        return;
+    }
+
+    qint64 delay = 0;
+    if (m_speed > 0.0) {
+        const qint64 due = qint64(m_trace.events[m_next].timestamp / m_speed);
+        delay = std::max(qint64(0), due - m_clock.elapsed());
+    }
+    // always go through the event loop, so that bindings, polish and animations
+    // get a chance to run between the events just like they would live.
+    QTimer::singleShot(std::chrono::milliseconds(delay), Qt::PreciseTimer, this, &PointerTraceReplayer::replayNext);
+}
+
+void PointerTraceReplayer::replayNext()
+{
+    const PointerTrace::Event &event = m_trace.events[m_next];
+    m_next += 1;
+
+    TriStateSwitch *control = m_switches.value(event.target);
+    if (control) {
+        deliver(control, event);
+    } else {
+        qWarning() << "PointerTraceReplayer: No switch at index" << event.target;
+    }
+    scheduleNext();
+}
+
+void PointerTraceReplayer::deliver(TriStateSwitch *control, const PointerTrace::Event &event)
+{
+    const QEvent::Type type = qtEventType(event.type);
+    QElapsedTimer timer;
+
+    if (PointerTrace::isMouseEvent(event.type)) {
+        QMouseEvent mouseEvent(type, event.position, control->mapToScene(event.position), control->mapToGlobal(event.position),
+                               Qt::MouseButton(event.button), Qt::MouseButtons::fromInt(event.buttons), Qt::NoModifier);
+        mouseEvent.setTimestamp(event.timestamp);
+        timer.start();
+        QCoreApplication::sendEvent(control, &mouseEvent);
+    } else {
+        QList<QEventPoint> points;
+        points.reserve(event.points.size());
+        for (const PointerTrace::TouchPoint &tp : event.points) {
+            QEventPoint point(tp.id, QEventPoint::State(tp.state), control->mapToScene(tp.position), control->mapToGlobal(tp.position));
+            QMutableEventPoint::setPosition(point, tp.position);
+            points.append(point);
+        }
+        QTouchEvent touchEvent(type, m_touchDevice, Qt::NoModifier, points);
+        touchEvent.setTimestamp(event.timestamp);
+        timer.start();
+        QCoreApplication::sendEvent(control, &touchEvent);
+    }
+
+    m_samples.append({event.type, event.target, timer.nsecsElapsed()});
+}
+
+QList<PointerTraceReplayer::Sample> PointerTraceReplayer::samples() const
+{
+    return m_samples;
+}
+
+QList<PointerTrace::SwitchState> PointerTraceReplayer::finalStates() const
+{
+    return m_finalStates;
+}
+
+bool PointerTraceReplayer::restoredInitialStates() const
+{
+    return m_restoredInitialStates;
+}
+
+bool PointerTraceReplayer::matchesRecording() const
+{
+    return m_restoredInitialStates && m_finalStates == m_trace.finalStates;
+}
+
+void PointerTraceReplayer::writeReport(QTextStream &stream) const
+{
+    stream << "# event\ttarget\ttype\tnanoseconds\n";
+    for (qsizetype i = 0; i < m_samples.size(); i++) {
+        const Sample &sample = m_samples[i];
+        stream << i << '\t' << sample.target << '\t' << PointerTrace::eventTypeName(sample.type) << '\t' << sample.nanoseconds << '\n';
+    }
+
+    stream << "# type\tcount\tmean ns\tmax ns\n";
+    for (quint8 t = 0; t <= quint8(PointerTrace::EventType::TouchCancel); t++) {
+        const auto type = static_cast<PointerTrace::EventType>(t);
+        qint64 count = 0, total = 0, max = 0;
+        for (const Sample &sample : m_samples) {
+            if (sample.type == type) {
+                count += 1;
+                total += sample.nanoseconds;
+                max = std::max(max, sample.nanoseconds);
+            }
+        }
+        if (count > 0) {
+            stream << PointerTrace::eventTypeName(type) << '\t' << count << '\t' << total / count << '\t' << max << '\n';
+        }
+    }
+
+    stream << "# switch\tcheckState\tposition\tcorners\trecorded checkState\trecorded position\trecorded corners\n";
+    for (qsizetype i = 0; i < m_finalStates.size(); i++) {
+        stream << i << '\t';
+        writeState(stream, m_finalStates[i]);
+        stream << '\t';
+        writeState(stream, m_trace.finalStates.value(i));
+        stream << '\n';
+    }
+    if (!m_restoredInitialStates) {
+        stream << "# initial states could NOT be restored, the window does not match the recording\n";
+    }
+    stream << "# final states " << (matchesRecording() ? "match" : "DO NOT match") << " the recording\n";
+}
+
+#include "moc_pointertrace.cpp"
@@ -0,0 +1,160 @@
+#ifndef POINTERTRACE_H
+#define POINTERTRACE_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QPointF>
+#include <QQuickWindow>
+#include <QTextStream>
+
+#include "tristatecorners.h"
+
+class QMouseEvent;
+class QPointingDevice;
+class QTouchEvent;
+class TriStateSwitch;
+
+// A compact binary recording of the pointer events delivered to every
+// TriStateSwitch in a window, along with the initial and final states of the switches.
+// Switches are identified by their depth-first order in the item tree,
+// so a trace can be replayed against any window with the same layout.
+struct PointerTrace
+{
+    enum class EventType : quint8 {
+        MousePress,
+        MouseMove,
+        MouseRelease,
+        MouseDoubleClick,
+        TouchBegin,
+        TouchUpdate,
+        TouchEnd,
+        TouchCancel,
+    };
+
+    struct TouchPoint
+    {
+        quint16 id = 0;
+        quint8 state = 0; // QEventPoint::State
+        QPointF position; // item coordinates
+    };
+
+    struct Event
+    {
+        quint32 timestamp = 0; // milliseconds since the start of the recording
+        quint16 target = 0; // index of the switch
+        EventType type = EventType::MouseMove;
+        quint8 button = 0;
+        quint8 buttons = 0;
+        QPointF position; // item coordinates, mouse events only
+        QList<TouchPoint> points; // touch events only
+    };
+
+    struct SwitchState
+    {
+        Qt::CheckState checkState = Qt::Unchecked;
+        QPointF position;
+        TriStateCorners corners;
+
+        bool operator==(const SwitchState &other) const;
+    };
+
+    QList<SwitchState> initialStates;
+    QList<SwitchState> finalStates;
+    QList<Event> events;
+
+    bool load(const QString &fileName, QString *errorString = nullptr);
+    bool save(const QString &fileName, QString *errorString = nullptr) const;
+
+    static bool isMouseEvent(EventType type);
+    static const char *eventTypeName(EventType type);
+    static QList<TriStateSwitch *> switchesIn(QQuickWindow *window);
+    static SwitchState stateOf(const TriStateSwitch *control);
+    static void restoreState(TriStateSwitch *control, const SwitchState &state);
+};
+
+// Records mouse and touch events delivered to the switches of a window.
+class PointerTraceRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PointerTraceRecorder(QQuickWindow *window, QObject *parent = nullptr);
+
+    // Captures the initial states of the switches, and starts recording.
+    void start();
+    void stop();
+
+    // Stops the recording if needed, and writes the trace including the final states of the switches.
+    bool save(const QString &fileName, QString *errorString = nullptr);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void recordMouseEvent(quint16 target, PointerTrace::EventType type, const QMouseEvent *event);
+    void recordTouchEvent(quint16 target, PointerTrace::EventType type, const QTouchEvent *event);
+
+    QPointer<QQuickWindow> m_window;
+    QList<QPointer<TriStateSwitch>> m_switches;
+    QElapsedTimer m_clock;
+    PointerTrace m_trace;
+};
+
+// Replays a trace directly into the mouseMoveEvent/touchEvent handlers of
+// the switches of a window, measuring how long each handler took.
+class PointerTraceReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Sample
+    {
+        PointerTrace::EventType type;
+        quint16 target;
+        qint64 nanoseconds;
+    };
+
+    explicit PointerTraceReplayer(QQuickWindow *window, QObject *parent = nullptr);
+
+    void setTrace(const PointerTrace &trace);
+
+    // 1.0 replays at the original speed, 2.0 twice as fast, etc.
+    // Zero or negative replays every event as soon as the previous one has been handled.
+    qreal speed() const;
+    void setSpeed(qreal speed);
+
+    // Restores the initial states of the switches as recorded, and starts replaying.
+    void start();
+
+    QList<Sample> samples() const;
+    QList<PointerTrace::SwitchState> finalStates() const;
+    // Whether the states of the switches could be restored to the recorded initial states.
+    bool restoredInitialStates() const;
+    // Whether the final states after the replay match the ones recorded in the trace.
+    bool matchesRecording() const;
+
+    void writeReport(QTextStream &stream) const;
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    void scheduleNext();
+    void replayNext();
+    void deliver(TriStateSwitch *control, const PointerTrace::Event &event);
+
+    QPointer<QQuickWindow> m_window;
+    QList<QPointer<TriStateSwitch>> m_switches;
+    QPointingDevice *m_touchDevice = nullptr;
+    PointerTrace m_trace;
+    qreal m_speed = 1.0;
+    qsizetype m_next = 0;
+    QElapsedTimer m_clock;
+    QList<Sample> m_samples;
+    QList<PointerTrace::SwitchState> m_finalStates;
+    bool m_restoredInitialStates = false;
+};
+
+#endif // POINTERTRACE_H
@@ -0,0 +1,309 @@
+#include "qualitygovernor.h"
+
+#include <QtCore/qhash.h>
+#include <QtQuick/qquickitem.h>
+
+#include <algorithm>
+
+namespace
+{
+
+// Frame times are measured from the end of the animation step to the swap, so they
+// may include waiting for vsync. Only a frame that exceeds the budget by a margin is
+// late, and headroom means staying close to the budget.
+constexpr qreal OVERLOAD_TOLERANCE = 1.25;
+constexpr qreal RECOVERY_TOLERANCE = 1.1;
+
+// Weight of the latest frame in the moving average.
+constexpr qreal SMOOTHING = 0.1;
+
+constexpr int MAX_RECOVERY_SCALE = 8;
+
+QHash<QQuickWindow *, QualityGovernor *> &governors()
+{
+    static QHash<QQuickWindow *, QualityGovernor *> instances;
+    return instances;
+}
+
+void unregisterGovernor(const QualityGovernor *governor)
+{
+    auto &instances = governors();
+    for (auto it = instances.begin(); it != instances.end();) {
+        if (it.value() == governor) {
+            it = instances.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+QList<QualityGovernorAttached *> &attachedObjects()
+{
+    static QList<QualityGovernorAttached *> instances;
+    return instances;
+}
+
+}
+
+QualityGovernor::QualityGovernor(QObject *parent)
+    : QObject{parent}
+{
+    m_clock.start();
+    m_headroomClock.start();
+    m_recoveryTimer.setSingleShot(true);
+    connect(&m_recoveryTimer, &QTimer::timeout, this, &QualityGovernor::checkRecovery);
+}
+
+QualityGovernor::~QualityGovernor()
+{
+    // the render thread must not deliver frames to a governor being destroyed
+    disconnect(m_swapConnection);
+    unregisterGovernor(this);
+    for (QualityGovernorAttached *attached : std::as_const(attachedObjects())) {
+        if (attached->m_governor == this) {
+            attached->updateGovernor();
+        }
+    }
+}
+
+QQuickWindow *QualityGovernor::window() const
+{
+    return m_window;
+}
+
+void QualityGovernor::setWindow(QQuickWindow *window)
+{
+    if (m_window == window) {
+        return;
+    }
+
+    disconnect(m_frameConnection);
+    disconnect(m_swapConnection);
+    disconnect(m_destroyedConnection);
+    unregisterGovernor(this);
+    m_window = window;
+    if (m_window) {
+        governors().insert(m_window, this);
+        // Only frames that were actually produced are timed, so an idle window
+        // yields no samples at all, rather than one long frame.
+        // afterAnimating is emitted on the GUI thread once per frame with every render loop.
+        m_frameConnection = connect(m_window, &QQuickWindow::afterAnimating, this, [this]() {
+            m_frameStart.store(m_clock.nsecsElapsed());
+        });
+        // frameSwapped is emitted on the render thread with the threaded render loop.
+        m_swapConnection = connect(m_window, &QQuickWindow::frameSwapped, this, [this]() {
+            const qint64 frameStart = m_frameStart.exchange(-1);
+            if (frameStart < 0) {
+                return;
+            }
+            const qreal frameTime = (m_clock.nsecsElapsed() - frameStart) / 1e6;
+            QMetaObject::invokeMethod(this, [this, frameTime]() {
+                handleFrame(frameTime);
+            });
+        }, Qt::DirectConnection);
+        m_destroyedConnection = connect(m_window, &QObject::destroyed, this, [this]() {
+            unregisterGovernor(this);
+        });
+    }
+    resetFrameStatistics();
+
+    for (QualityGovernorAttached *attached : std::as_const(attachedObjects())) {
+        attached->updateGovernor();
+    }
+    Q_EMIT windowChanged();
+}
+
+QualityGovernor::Tier QualityGovernor::tier() const
+{
+    return m_tier;
+}
+
+qreal QualityGovernor::frameBudget() const
+{
+    return m_frameBudget;
+}
+
+void QualityGovernor::setFrameBudget(qreal frameBudget)
+{
+    if (qFuzzyCompare(m_frameBudget, frameBudget) || frameBudget <= 0.0) {
+        return;
+    }
+    m_frameBudget = frameBudget;
+    resetFrameStatistics();
+    Q_EMIT frameBudgetChanged();
+}
+
+int QualityGovernor::overloadFrames() const
+{
+    return m_overloadFrames;
+}
+
+void QualityGovernor::setOverloadFrames(int frames)
+{
+    frames = std::max(frames, 1);
+    if (m_overloadFrames == frames) {
+        return;
+    }
+    m_overloadFrames = frames;
+    Q_EMIT overloadFramesChanged();
+}
+
+int QualityGovernor::recoveryTime() const
+{
+    return m_recoveryTime;
+}
+
+void QualityGovernor::setRecoveryTime(int milliseconds)
+{
+    milliseconds = std::max(milliseconds, 1);
+    if (m_recoveryTime == milliseconds) {
+        return;
+    }
+    m_recoveryTime = milliseconds;
+    scheduleRecovery();
+    Q_EMIT recoveryTimeChanged();
+}
+
+QualityGovernor *QualityGovernor::governorFor(QQuickWindow *window)
+{
+    return governors().value(window);
+}
+
+QualityGovernorAttached *QualityGovernor::qmlAttachedProperties(QObject *object)
+{
+    return new QualityGovernorAttached(object);
+}
+
+void QualityGovernor::handleFrame(qreal frameTime)
+{
+    m_averageFrameTime = m_averageFrameTime < 0.0
+        ? frameTime
+        : m_averageFrameTime + (frameTime - m_averageFrameTime) * SMOOTHING;
+
+    if (m_averageFrameTime > m_frameBudget * RECOVERY_TOLERANCE) {
+        m_headroomClock.start();
+        scheduleRecovery();
+    }
+    if (m_averageFrameTime > m_frameBudget * OVERLOAD_TOLERANCE) {
+        m_overloadCount += 1;
+    } else {
+        m_overloadCount = 0;
+    }
+
+    if (m_overloadCount >= m_overloadFrames && m_tier < NoAnimation) {
+        if (m_lastStepWasUp) {
+            // the previous tier could not be sustained, be more careful next time
+            m_recoveryScale = std::min(m_recoveryScale * 2, MAX_RECOVERY_SCALE);
+        }
+        m_lastStepWasUp = false;
+        stepTo(static_cast<Tier>(m_tier + 1));
+    }
+}
+
+void QualityGovernor::resetFrameStatistics()
+{
+    m_frameStart.store(-1);
+    m_averageFrameTime = -1.0;
+    m_overloadCount = 0;
+}
+
+void QualityGovernor::scheduleRecovery()
+{
+    // keep checking while there is anything to recover: a lower tier, a back-off
+    // that has yet to decay, or a step up that still has to prove itself.
+    if (m_tier == FullQuality && m_recoveryScale == 1 && !m_lastStepWasUp) {
+        m_recoveryTimer.stop();
+        return;
+    }
+    // not driven by frames, so that an idle window recovers as well
+    const qint64 remaining = qint64(m_recoveryTime) * m_recoveryScale - m_headroomClock.elapsed();
+    m_recoveryTimer.start(std::chrono::milliseconds(std::max(remaining, qint64(0))));
+}
+
+void QualityGovernor::checkRecovery()
+{
+    if (m_headroomClock.elapsed() < qint64(m_recoveryTime) * m_recoveryScale) {
+        scheduleRecovery();
+        return;
+    }
+
+    // The previous step up held, or there is nothing left to step up: either way a whole
+    // period passed without late frames, so the back-off decays until it is gone.
+    if (m_lastStepWasUp || m_tier == FullQuality) {
+        m_recoveryScale = std::max(m_recoveryScale / 2, 1);
+    }
+    if (m_tier > FullQuality) {
+        m_lastStepWasUp = true;
+        stepTo(static_cast<Tier>(m_tier - 1));
+    } else {
+        m_lastStepWasUp = false;
+        m_headroomClock.start();
+        scheduleRecovery();
+    }
+}
+
+void QualityGovernor::stepTo(Tier tier)
+{
+    const Tier previousTier = m_tier;
+    const qreal averageFrameTime = m_averageFrameTime;
+
+    m_tier = tier;
+    // start over: the new tier needs its own evidence
+    m_averageFrameTime = -1.0;
+    m_overloadCount = 0;
+    m_headroomClock.start();
+    scheduleRecovery();
+
+    Q_EMIT tierChanged();
+    Q_EMIT tierStepped(previousTier, m_tier, averageFrameTime);
+}
+
+QualityGovernorAttached::QualityGovernorAttached(QObject *parent)
+    : QObject{parent}
+{
+    attachedObjects().append(this);
+    if (auto item = qobject_cast<QQuickItem *>(parent)) {
+        connect(item, &QQuickItem::windowChanged, this, &QualityGovernorAttached::updateGovernor);
+    }
+    updateGovernor();
+}
+
+QualityGovernorAttached::~QualityGovernorAttached()
+{
+    attachedObjects().removeOne(this);
+}
+
+QualityGovernor::Tier QualityGovernorAttached::tier() const
+{
+    return m_tier;
+}
+
+void QualityGovernorAttached::updateGovernor()
+{
+    QQuickWindow *window = qobject_cast<QQuickWindow *>(parent());
+    if (auto item = qobject_cast<QQuickItem *>(parent())) {
+        window = item->window();
+    }
+
+    QualityGovernor *governor = QualityGovernor::governorFor(window);
+    if (m_governor != governor) {
+        disconnect(m_tierConnection);
+        m_governor = governor;
+        if (m_governor) {
+            m_tierConnection = connect(m_governor, &QualityGovernor::tierChanged, this, &QualityGovernorAttached::updateTier);
+        }
+    }
+    updateTier();
+}
+
+void QualityGovernorAttached::updateTier()
+{
+    const QualityGovernor::Tier tier = m_governor ? m_governor->tier() : QualityGovernor::FullQuality;
+    if (m_tier == tier) {
+        return;
+    }
+    m_tier = tier;
+    Q_EMIT tierChanged();
+}
+
+#include "moc_qualitygovernor.cpp"
@@ -0,0 +1,132 @@
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QQmlEngine>
+#include <QQuickWindow>
+#include <QTimer>
+
+#include <atomic>
+
+class QualityGovernorAttached;
+
+// Watches frame times of a window, and under sustained overload steps the quality
+// of the switches in it down one tier at a time. When frames are back within the
+// budget for long enough, including while the window is idle, the quality is
+// stepped back up.
+//
+// Items read the current tier of their window via the attached QualityGovernor.tier property.
+class QualityGovernor : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QQuickWindow *window READ window WRITE setWindow NOTIFY windowChanged FINAL)
+    Q_PROPERTY(Tier tier READ tier NOTIFY tierChanged FINAL)
+    Q_PROPERTY(qreal frameBudget READ frameBudget WRITE setFrameBudget NOTIFY frameBudgetChanged FINAL)
+    Q_PROPERTY(int overloadFrames READ overloadFrames WRITE setOverloadFrames NOTIFY overloadFramesChanged FINAL)
+    Q_PROPERTY(int recoveryTime READ recoveryTime WRITE setRecoveryTime NOTIFY recoveryTimeChanged FINAL)
+    QML_ELEMENT
+    QML_ATTACHED(QualityGovernorAttached)
+
+public:
+    // Each tier disables everything the previous ones did.
+    enum Tier {
+        FullQuality,
+        NoShadow,
+        NoMultisampling,
+        NoAnimation,
+    };
+    Q_ENUM(Tier)
+
+    explicit QualityGovernor(QObject *parent = nullptr);
+    ~QualityGovernor() override;
+
+    QQuickWindow *window() const;
+    void setWindow(QQuickWindow *window);
+
+    Tier tier() const;
+
+    // Frame time in milliseconds which is not supposed to be exceeded.
+    qreal frameBudget() const;
+    void setFrameBudget(qreal frameBudget);
+
+    // Number of consecutive frames over the budget before stepping down.
+    int overloadFrames() const;
+    void setOverloadFrames(int frames);
+
+    // Time in milliseconds without late frames before stepping up.
+    int recoveryTime() const;
+    void setRecoveryTime(int milliseconds);
+
+    static QualityGovernor *governorFor(QQuickWindow *window);
+    static QualityGovernorAttached *qmlAttachedProperties(QObject *object);
+
+Q_SIGNALS:
+    void windowChanged();
+    void tierChanged();
+    void frameBudgetChanged();
+    void overloadFramesChanged();
+    void recoveryTimeChanged();
+
+    // Emitted on every tier change, meant for telemetry.
+    void tierStepped(QualityGovernor::Tier previousTier, QualityGovernor::Tier tier, qreal averageFrameTime);
+
+private:
+    void handleFrame(qreal frameTime);
+    void resetFrameStatistics();
+    void scheduleRecovery();
+    void checkRecovery();
+    void stepTo(Tier tier);
+
+    QPointer<QQuickWindow> m_window;
+    QMetaObject::Connection m_frameConnection;
+    QMetaObject::Connection m_swapConnection;
+    QMetaObject::Connection m_destroyedConnection;
+    Tier m_tier = FullQuality;
+    qreal m_frameBudget = 16.0;
+    int m_overloadFrames = 30;
+    int m_recoveryTime = 5000;
+
+    // started once and only read afterwards, so that the render thread can read it too
+    QElapsedTimer m_clock;
+    // when the current frame finished animating, or -1 if no frame is in flight
+    std::atomic<qint64> m_frameStart = -1;
+    qreal m_averageFrameTime = -1.0;
+    int m_overloadCount = 0;
+    // time since the last late frame, idle time counts as headroom too
+    QElapsedTimer m_headroomClock;
+    QTimer m_recoveryTimer;
+    // grows every time stepping up had to be reverted, so that the tiers don't flip-flop,
+    // and halves for every whole recovery time a step up holds, or full quality lasts.
+    int m_recoveryScale = 1;
+    bool m_lastStepWasUp = false;
+};
+
+class QualityGovernorAttached : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QualityGovernor::Tier tier READ tier NOTIFY tierChanged FINAL)
+    QML_ANONYMOUS
+
+public:
+    explicit QualityGovernorAttached(QObject *parent = nullptr);
+    ~QualityGovernorAttached() override;
+
+    QualityGovernor::Tier tier() const;
+
+Q_SIGNALS:
+    void tierChanged();
+
+private:
+    friend class QualityGovernor;
+
+    void updateGovernor();
+    void updateTier();
+
+    QPointer<QualityGovernor> m_governor;
+    QMetaObject::Connection m_tierConnection;
+    QualityGovernor::Tier m_tier = QualityGovernor::FullQuality;
+};
+
+#endif // QUALITYGOVERNOR_H
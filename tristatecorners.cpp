@@ -0,0 +1,98 @@
+#include "tristatecorners.h"
+
+#include <QStringBuilder>
+
+using namespace Qt::StringLiterals;
+
+TriStateCorners::TriStateCorners(QPointF unchecked, QPointF partiallyChecked, QPointF checked)
+    : m_unchecked(unchecked)
+    , m_partiallyChecked(partiallyChecked)
+    , m_checked(checked)
+{
+}
+
+TriStateCorners::TriStateCorners(const QVariantList &points)
+{
+    if (points.size() != 3) {
+        return;
+    }
+    m_unchecked = points[0].toPointF();
+    m_partiallyChecked = points[1].toPointF();
+    m_checked = points[2].toPointF();
+}
+
+QPointF TriStateCorners::unchecked() const
+{
+    return m_unchecked;
+}
+
+void TriStateCorners::setUnchecked(QPointF point)
+{
+    m_unchecked = point;
+}
+
+QPointF TriStateCorners::partiallyChecked() const
+{
+    return m_partiallyChecked;
+}
+
+void TriStateCorners::setPartiallyChecked(QPointF point)
+{
+    m_partiallyChecked = point;
+}
+
+QPointF TriStateCorners::checked() const
+{
+    return m_checked;
+}
+
+void TriStateCorners::setChecked(QPointF point)
+{
+    m_checked = point;
+}
+
+QPointF TriStateCorners::at(int index) const
+{
+    switch (index) {
+    case Qt::CheckState::Unchecked:
+        return m_unchecked;
+    case Qt::CheckState::PartiallyChecked:
+        return m_partiallyChecked;
+    case Qt::CheckState::Checked:
+        return m_checked;
+    default:
+        return {};
+    }
+}
+
+QList<QPointF> TriStateCorners::toList() const
+{
+    return {m_unchecked, m_partiallyChecked, m_checked};
+}
+
+QString TriStateCorners::toString() const
+{
+    auto point = [](QPointF p) -> QString {
+        return u"Qt.point("_s % QString::number(p.x()) % u", "_s % QString::number(p.y()) % u')';
+    };
+    return u"triStateCorners("_s % point(m_unchecked) % u", "_s % point(m_partiallyChecked) % u", "_s % point(m_checked) % u')';
+}
+
+std::array<QPointF, 3> TriStateCorners::points() const
+{
+    return {m_unchecked, m_partiallyChecked, m_checked};
+}
+
+bool operator==(const TriStateCorners &a, const TriStateCorners &b)
+{
+    return a.m_unchecked == b.m_unchecked && a.m_partiallyChecked == b.m_partiallyChecked && a.m_checked == b.m_checked;
+}
+
+QDebug operator<<(QDebug debug, const TriStateCorners &corners)
+{
+    QDebugStateSaver saver(debug);
+    debug.nospace() << "TriStateCorners(" << corners.unchecked() << ", " << corners.partiallyChecked() << ", " << corners.checked() << ')';
+    return debug;
+}
+
+#include "moc_tristatecorners.cpp"
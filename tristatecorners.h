@@ -0,0 +1,58 @@
+#ifndef TRISTATECORNERS_H
+#define TRISTATECORNERS_H
+
+#include <QDebug>
+#include <QPointF>
+#include <QQmlEngine>
+#include <QSizeF>
+#include <QVariantList>
+
+#include <array>
+
+// Locations of the three states of a TriStateSwitch in normalized coordinates.
+// A fixed-size value type, so that passing it around does not allocate.
+class TriStateCorners
+{
+    Q_GADGET
+    Q_PROPERTY(QPointF unchecked READ unchecked WRITE setUnchecked FINAL)
+    Q_PROPERTY(QPointF partiallyChecked READ partiallyChecked WRITE setPartiallyChecked FINAL)
+    Q_PROPERTY(QPointF checked READ checked WRITE setChecked FINAL)
+    QML_VALUE_TYPE(triStateCorners)
+    QML_CONSTRUCTIBLE_VALUE
+
+public:
+    TriStateCorners() = default;
+    TriStateCorners(QPointF unchecked, QPointF partiallyChecked, QPointF checked);
+
+    // Conversion from a JS array of three points, in the order Unchecked, PartiallyChecked, Checked.
+    // Anything else results in all-zero corners, which TriStateSwitch rejects.
+    Q_INVOKABLE TriStateCorners(const QVariantList &points);
+
+    QPointF unchecked() const;
+    void setUnchecked(QPointF point);
+
+    QPointF partiallyChecked() const;
+    void setPartiallyChecked(QPointF point);
+
+    QPointF checked() const;
+    void setChecked(QPointF point);
+
+    // Index in the order of Qt::CheckState.
+    Q_INVOKABLE QPointF at(int index) const;
+    Q_INVOKABLE QList<QPointF> toList() const;
+    Q_INVOKABLE QString toString() const;
+
+    std::array<QPointF, 3> points() const;
+
+    friend bool operator==(const TriStateCorners &a, const TriStateCorners &b);
+    friend bool operator!=(const TriStateCorners &a, const TriStateCorners &b) { return !(a == b); }
+
+private:
+    QPointF m_unchecked;
+    QPointF m_partiallyChecked;
+    QPointF m_checked;
+};
+
+QDebug operator<<(QDebug debug, const TriStateCorners &corners);
+
+#endif // TRISTATECORNERS_H
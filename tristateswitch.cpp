@@ -1,5 +1,6 @@
 #include "tristateswitch.h"
 
+#include <QtCore/qscopedvaluerollback.h>
 #include <QtGui/qstylehints.h>
 #include <QtGui/qguiapplication.h>
 #include <QtGui/QVector2D>
@@ -7,7 +8,11 @@
 #include <QtQuick/private/qquickevents_p_p.h>
 #include <QtQuickTemplates2/private/qquickabstractbutton_p_p.h>
 
+#include <optional>
+#include <utility>
+
 #include "geometryutils.h"
+#include "tristateswitchbatch.h"
 
 class TriStateSwitchPrivate : public QQuickAbstractButtonPrivate
 {
@@ -24,9 +29,24 @@ public:
 
     QPalette defaultPalette() const override { return QQuickTheme::palette(QQuickTheme::Switch); }
 
-    QPointF cornerUnchecked{0.0, 0.0};
-    QPointF cornerPartiallyChecked{1.0, 0.0};
-    QPointF cornerChecked{1.0, 1.0};
+    // Returns true if the change notifications should be deferred, see TriStateSwitchBatch.
+    // Must be called before the state gets modified.
+    bool deferNotifications();
+    void emitDeferredNotifications();
+
+    struct NotifiedState
+    {
+        QPointF position;
+        Qt::CheckState checkState;
+        bool checked;
+        TriStateCorners corners;
+    };
+    // state as of the last emitted notifications, while a batch is open
+    std::optional<NotifiedState> notifiedState;
+    // set while following a change that QQuickAbstractButton has already notified about
+    bool notifyImmediately = false;
+
+    TriStateCorners corners{{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0}};
 
     QPointF position{0.0, 0.0};
 
@@ -53,26 +73,26 @@ QPointF TriStateSwitchPrivate::checkStateToPosition(Qt::CheckState checkState) c
     switch (checkState) {
     case Qt::CheckState::Unchecked:
     default:
-        return cornerUnchecked;
+        return corners.unchecked();
     case Qt::CheckState::PartiallyChecked:
-        return cornerPartiallyChecked;
+        return corners.partiallyChecked();
     case Qt::CheckState::Checked:
-        return cornerChecked;
+        return corners.checked();
     }
 }
 
 std::tuple<Qt::CheckState, QPointF> TriStateSwitchPrivate::positionToCheckState(QPointF position) const
 {
-    const qreal distanceUnchecked = QVector2D(position - cornerUnchecked).length();
-    const qreal distancePartiallyChecked = QVector2D(position - cornerPartiallyChecked).length();
-    const qreal distanceChecked = QVector2D(position - cornerChecked).length();
+    const qreal distanceUnchecked = QVector2D(position - corners.unchecked()).length();
+    const qreal distancePartiallyChecked = QVector2D(position - corners.partiallyChecked()).length();
+    const qreal distanceChecked = QVector2D(position - corners.checked()).length();
 
     if (distanceUnchecked <= distancePartiallyChecked && distanceUnchecked <= distanceChecked) {
-        return {Qt::CheckState::Unchecked, cornerUnchecked};
+        return {Qt::CheckState::Unchecked, corners.unchecked()};
     } else if (distancePartiallyChecked <= distanceChecked) {
-        return {Qt::CheckState::PartiallyChecked, cornerPartiallyChecked};
+        return {Qt::CheckState::PartiallyChecked, corners.partiallyChecked()};
     } else {
-        return {Qt::CheckState::Checked, cornerChecked};
+        return {Qt::CheckState::Checked, corners.checked()};
     }
 }
 
@@ -106,6 +126,50 @@ bool TriStateSwitchPrivate::handleRelease(const QPointF &point, ulong timestamp)
     return true;
 }
 
+bool TriStateSwitchPrivate::deferNotifications()
+{
+    Q_Q(TriStateSwitch);
+    if (notifyImmediately || !TriStateSwitchBatch::isActive()) {
+        return false;
+    }
+    if (!notifiedState.has_value()) {
+        notifiedState = NotifiedState{position, checkState, checked, corners};
+        TriStateSwitchBatch::enqueue(q);
+    }
+    return true;
+}
+
+void TriStateSwitchPrivate::emitDeferredNotifications()
+{
+    Q_Q(TriStateSwitch);
+    if (!notifiedState.has_value()) {
+        return;
+    }
+    const NotifiedState notified = *std::exchange(notifiedState, std::nullopt);
+
+    // Compare everything up front: handlers may change this switch again,
+    // which then notifies immediately on its own.
+    const bool checkStateChanged = notified.checkState != checkState;
+    const bool checkedChanged = notified.checked != checked;
+    const bool positionChanged = !qFuzzyCompare(notified.position, position);
+    const bool cornersChanged = notified.corners != corners;
+
+    // same order as the immediate notifications
+    if (checkStateChanged) {
+        Q_EMIT q->checkStateChanged();
+    }
+    if (checkedChanged) {
+        Q_EMIT q->checkedChanged();
+    }
+    if (positionChanged) {
+        Q_EMIT q->positionChanged();
+        Q_EMIT q->visualPositionChanged();
+    }
+    if (cornersChanged) {
+        Q_EMIT q->cornersChanged();
+    }
+}
+
 TriStateSwitch::TriStateSwitch(QQuickItem *parent)
     : QQuickAbstractButton(*(new TriStateSwitchPrivate), parent)
 {
@@ -124,14 +188,18 @@ void TriStateSwitch::setPosition(QPointF position)
 {
     Q_D(TriStateSwitch);
 
-    position = GeometryUtils::snapPointToTriangle(d->cornerUnchecked, d->cornerPartiallyChecked, d->cornerChecked, position);
+    position = GeometryUtils::snapPointToTriangle(d->corners, position);
 
     position = { std::clamp(position.x(), qreal(0.0), qreal(1.0)), std::clamp(position.y(), qreal(0.0), qreal(1.0)) };
     if (qFuzzyCompare(d->position, position)) {
         return;
     }
 
+    const bool deferred = d->deferNotifications();
     d->position = position;
+    if (deferred) {
+        return;
+    }
     Q_EMIT positionChanged();
     Q_EMIT visualPositionChanged();
 }
@@ -196,12 +264,15 @@ void TriStateSwitch::setCheckState(Qt::CheckState state)
         return;
     }
 
+    const bool deferred = d->deferNotifications();
     bool wasChecked = isChecked();
     d->checked = state == Qt::Checked;
     d->checkState = state;
-    Q_EMIT checkStateChanged();
-    if (d->checked != wasChecked) {
-        Q_EMIT checkedChanged();
+    if (!deferred) {
+        Q_EMIT checkStateChanged();
+        if (d->checked != wasChecked) {
+            Q_EMIT checkedChanged();
+        }
     }
     setPosition(d->checkStateToPosition(d->checkState));
 }
@@ -236,23 +307,24 @@ void TriStateSwitch::nextCheckState()
     }
 }
 
-QList<QPointF> TriStateSwitch::corners() const
+TriStateCorners TriStateSwitch::corners() const
 {
     Q_D(const TriStateSwitch);
-    return {d->cornerUnchecked, d->cornerPartiallyChecked, d->cornerChecked};
+    return d->corners;
 }
 
-void TriStateSwitch::setCorners(const QList<QPointF> &corners)
+void TriStateSwitch::setCorners(const TriStateCorners &corners)
 {
     Q_D(TriStateSwitch);
-    if (corners.size() != 3) {
+    if (d->corners == corners) {
         return;
     }
-    if (qFuzzyCompare(corners[0], corners[1]) || qFuzzyCompare(corners[1], corners[2]) || qFuzzyCompare(corners[2], corners[0])) {
+    const auto points = corners.points();
+    if (qFuzzyCompare(points[0], points[1]) || qFuzzyCompare(points[1], points[2]) || qFuzzyCompare(points[2], points[0])) {
         return;
     }
     bool left = false, right = false, top = false, bottom = false;
-    for (const QPointF corner : corners) {
+    for (const QPointF corner : points) {
         // each point much be on some edge
         if (!(corner.x() == 0.0 || corner.x() == 1.0 || corner.y() == 0.0 || corner.y() == 1.0)) {
             qDebug() << "TriStateSwitch: Some corner is not at the edge of the boundary:" << corner;
@@ -275,17 +347,26 @@ void TriStateSwitch::setCorners(const QList<QPointF> &corners)
         return;
     }
     // should it be allowed to have all the corners at one line, i.e. not on a 2D plane?
-    d->cornerUnchecked = corners[0];
-    d->cornerPartiallyChecked = corners[1];
-    d->cornerChecked = corners[2];
+    const bool deferred = d->deferNotifications();
+    d->corners = corners;
     setPosition(d->checkStateToPosition(d->checkState));
-    Q_EMIT cornersChanged();
+    if (!deferred) {
+        Q_EMIT cornersChanged();
+    }
 }
 
 void TriStateSwitch::buttonChange(ButtonChange change)
 {
     Q_D(TriStateSwitch);
     if (change == ButtonCheckedChange) {
+        // QQuickAbstractButton notifies about checked right away, even within a batch.
+        // Flush whatever is pending for this switch and follow suit, so that the
+        // notifications of a switch never end up split around the batch commit.
+        if (d->notifiedState.has_value()) {
+            d->notifiedState->checked = d->checked;
+            d->emitDeferredNotifications();
+        }
+        const QScopedValueRollback<bool> immediately(d->notifyImmediately, true);
         setCheckState(isChecked() ? Qt::Checked : Qt::Unchecked);
     } else {
         QQuickAbstractButton::buttonChange(change);
@@ -297,4 +378,10 @@ QFont TriStateSwitch::defaultFont() const
     return QQuickTheme::font(QQuickTheme::Switch);
 }
 
+void TriStateSwitch::emitDeferredNotifications()
+{
+    Q_D(TriStateSwitch);
+    d->emitDeferredNotifications();
+}
+
 #include "moc_tristateswitch.cpp"
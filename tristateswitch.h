@@ -7,6 +7,8 @@
 #include <QtQuickTemplates2/private/qquickabstractbutton_p.h>
 #include <QtQuickTemplates2/private/qquickswitch_p.h>
 
+#include "tristatecorners.h"
+
 class TriStateSwitchPrivate;
 
 class TriStateSwitch : public QQuickAbstractButton
@@ -16,7 +18,7 @@ class TriStateSwitch : public QQuickAbstractButton
     Q_PROPERTY(QPointF visualPosition READ visualPosition NOTIFY visualPositionChanged FINAL)
     Q_PROPERTY(Qt::CheckState checkState READ checkState WRITE setCheckState NOTIFY checkStateChanged FINAL)
     Q_PROPERTY(QJSValue nextCheckState READ getNextCheckState WRITE setNextCheckState NOTIFY nextCheckStateChanged FINAL)
-    Q_PROPERTY(QList<QPointF> corners READ corners WRITE setCorners NOTIFY cornersChanged FINAL)
+    Q_PROPERTY(TriStateCorners corners READ corners WRITE setCorners NOTIFY cornersChanged FINAL)
     QML_NAMED_ELEMENT(TriStateSwitch)
 
 public:
@@ -33,8 +35,8 @@ public:
     QJSValue getNextCheckState() const;
     void setNextCheckState(const QJSValue &callback);
 
-    QList<QPointF> corners() const;
-    void setCorners(const QList<QPointF> &corners);
+    TriStateCorners corners() const;
+    void setCorners(const TriStateCorners &corners);
 
 Q_SIGNALS:
     void positionChanged();
@@ -57,6 +59,10 @@ protected:
     QFont defaultFont() const override;
 
 private:
+    // the only part of the private implementation TriStateSwitchBatch gets to use
+    friend class TriStateSwitchBatch;
+    void emitDeferredNotifications();
+
     Q_DISABLE_COPY(TriStateSwitch)
     Q_DECLARE_PRIVATE(TriStateSwitch)
 };
@@ -0,0 +1,82 @@
+#include "tristateswitchbatch.h"
+
+#include <QtCore/qpointer.h>
+#include <QtQml/qjsengine.h>
+
+#include <utility>
+
+#include "tristateswitch.h"
+
+namespace
+{
+
+int batchDepth = 0;
+QList<QPointer<TriStateSwitch>> batchedSwitches;
+
+}
+
+TriStateSwitchBatch::Scope::Scope()
+{
+    TriStateSwitchBatch::begin();
+}
+
+TriStateSwitchBatch::Scope::~Scope()
+{
+    TriStateSwitchBatch::commit();
+}
+
+TriStateSwitchBatch::TriStateSwitchBatch(QObject *parent)
+    : QObject{parent}
+{
+}
+
+void TriStateSwitchBatch::begin()
+{
+    batchDepth += 1;
+}
+
+void TriStateSwitchBatch::commit()
+{
+    if (batchDepth == 0) {
+        qWarning() << "TriStateSwitchBatch: commit() without a matching begin()";
+        return;
+    }
+    batchDepth -= 1;
+    if (batchDepth > 0) {
+        return;
+    }
+
+    // handlers may change switches again, which then notify immediately
+    const QList<QPointer<TriStateSwitch>> switches = std::exchange(batchedSwitches, {});
+    for (TriStateSwitch *control : switches) {
+        if (control) {
+            control->emitDeferredNotifications();
+        }
+    }
+}
+
+void TriStateSwitchBatch::run(const QJSValue &callback)
+{
+    begin();
+    const QJSValue result = callback.call();
+    // commit before rethrowing, otherwise handlers of the notifications would
+    // pick up the pending exception and report it as their own
+    commit();
+    if (result.isError()) {
+        if (QJSEngine *engine = qjsEngine(this)) {
+            engine->throwError(result);
+        }
+    }
+}
+
+bool TriStateSwitchBatch::isActive()
+{
+    return batchDepth > 0;
+}
+
+void TriStateSwitchBatch::enqueue(TriStateSwitch *control)
+{
+    batchedSwitches.append(control);
+}
+
+#include "moc_tristateswitchbatch.cpp"
@@ -0,0 +1,56 @@
+#ifndef TRISTATESWITCHBATCH_H
+#define TRISTATESWITCHBATCH_H
+
+#include <QJSValue>
+#include <QObject>
+#include <QQmlEngine>
+
+class TriStateSwitch;
+class TriStateSwitchPrivate;
+
+// While a batch is open, switches still update their properties right away,
+// but defer the change notifications. When the outermost batch is committed,
+// every switch emits its net change once, and nothing at all if it ended up
+// where it started.
+//
+// Writing `checked` is the exception: QQuickAbstractButton notifies about it
+// immediately, so the switch flushes and notifies about everything at once too.
+class TriStateSwitchBatch : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_SINGLETON
+
+public:
+    // Opens a batch for the lifetime of the scope.
+    class Scope
+    {
+    public:
+        Scope();
+        ~Scope();
+
+    private:
+        Q_DISABLE_COPY_MOVE(Scope)
+    };
+
+    explicit TriStateSwitchBatch(QObject *parent = nullptr);
+
+    // Batches can be nested, every begin() must be matched by a commit().
+    // Not available to QML, where an exception in between would leave the batch open forever.
+    static void begin();
+    static void commit();
+
+    // Calls the function within a batch, and commits it even if the function throws,
+    // before rethrowing the error to the caller.
+    Q_INVOKABLE void run(const QJSValue &callback);
+
+    static bool isActive();
+
+private:
+    friend class TriStateSwitchPrivate;
+
+    // Called by a switch the first time it defers a notification within a batch.
+    static void enqueue(TriStateSwitch *control);
+};
+
+#endif // TRISTATESWITCHBATCH_H
@@ -0,0 +1,270 @@
+#include "tristateswitchknobicon.h"
+
+#include <QtCore/qmath.h>
+#include <QtQuick/qsggeometry.h>
+#include <QtQuick/qsgnode.h>
+#include <QtQuick/qsgvertexcolormaterial.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "geometryutils.h"
+
+namespace
+{
+
+// Every line of the icon is a pill: a rectangle with fully rounded ends.
+// A single dot is a pill of zero length.
+constexpr int NUM_PILLS = 4;
+// Segments per rounded end.
+constexpr int CAP_SEGMENTS = 8;
+constexpr int PERIMETER_POINTS = 2 * (CAP_SEGMENTS + 1);
+// A center, and the inner and outer rings of the antialiasing fringe.
+constexpr int PILL_VERTICES = 1 + 2 * PERIMETER_POINTS;
+// Triangle fan for the body, and two triangles per perimeter point for the fringe.
+constexpr int PILL_INDICES = 3 * PERIMETER_POINTS + 6 * PERIMETER_POINTS;
+// Half of the width of the antialiasing fringe.
+constexpr float FRINGE = 0.5f;
+
+struct Pill
+{
+    QRectF rect;
+    qreal opacity;
+};
+
+void fillPillIndices(quint16 *indices, quint16 base)
+{
+    const quint16 center = base;
+    const quint16 inner = base + 1;
+    const quint16 outer = base + 1 + PERIMETER_POINTS;
+    for (int i = 0; i < PERIMETER_POINTS; i++) {
+        const quint16 next = (i + 1) % PERIMETER_POINTS;
+        *indices++ = center;
+        *indices++ = inner + i;
+        *indices++ = inner + next;
+
+        *indices++ = inner + i;
+        *indices++ = outer + i;
+        *indices++ = inner + next;
+
+        *indices++ = inner + next;
+        *indices++ = outer + i;
+        *indices++ = outer + next;
+    }
+}
+
+void fillPillVertices(QSGGeometry::ColoredPoint2D *vertices, const Pill &pill, const QColor &color)
+{
+    const float radius = float(std::min(pill.rect.width(), pill.rect.height()) / 2.0);
+    const QPointF center = pill.rect.center();
+    // centers of the rounded ends, along the longer side
+    const QPointF extent = pill.rect.width() >= pill.rect.height()
+        ? QPointF(pill.rect.width() / 2.0 - radius, 0.0)
+        : QPointF(0.0, pill.rect.height() / 2.0 - radius);
+    const QPointF capStart = center - extent;
+    const QPointF capEnd = center + extent;
+    const float direction = pill.rect.width() >= pill.rect.height() ? 0.0f : float(M_PI_2);
+
+    // premultiplied alpha
+    const float alpha = float(color.alphaF() * pill.opacity);
+    const uchar r = uchar(color.red() * alpha);
+    const uchar g = uchar(color.green() * alpha);
+    const uchar b = uchar(color.blue() * alpha);
+    const uchar a = uchar(255.0f * alpha);
+
+    vertices[0].set(float(center.x()), float(center.y()), r, g, b, a);
+
+    QSGGeometry::ColoredPoint2D *inner = vertices + 1;
+    QSGGeometry::ColoredPoint2D *outer = vertices + 1 + PERIMETER_POINTS;
+    for (int i = 0; i < PERIMETER_POINTS; i++) {
+        const bool atEnd = i <= CAP_SEGMENTS;
+        const QPointF cap = atEnd ? capEnd : capStart;
+        const int step = atEnd ? i : i - (CAP_SEGMENTS + 1);
+        const float angle = direction + float(atEnd ? -M_PI_2 : M_PI_2) + float(M_PI) * step / CAP_SEGMENTS;
+        const float cosine = std::cos(angle);
+        const float sine = std::sin(angle);
+        const float innerRadius = std::max(radius - FRINGE, 0.0f);
+        const float outerRadius = radius + FRINGE;
+        inner[i].set(float(cap.x()) + cosine * innerRadius, float(cap.y()) + sine * innerRadius, r, g, b, a);
+        outer[i].set(float(cap.x()) + cosine * outerRadius, float(cap.y()) + sine * outerRadius, 0, 0, 0, 0);
+    }
+}
+
+}
+
+TriStateSwitchKnobIcon::TriStateSwitchKnobIcon(QQuickItem *parent)
+    : QQuickItem{parent}
+{
+    setFlag(ItemHasContents);
+
+    // same as the NumberBehavior of the indicator
+    m_animation.setDuration(500);
+    m_animation.setEasingCurve(QEasingCurve::OutCubic);
+    connect(&m_animation, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) {
+        setVisualPosition(value.toPointF());
+    });
+}
+
+QPointF TriStateSwitchKnobIcon::position() const
+{
+    return m_position;
+}
+
+void TriStateSwitchKnobIcon::setPosition(QPointF position)
+{
+    if (m_position == position) {
+        return;
+    }
+    m_position = position;
+
+    m_animation.stop();
+    // like a Behavior, don't animate the initial value
+    if (m_animated && isComponentComplete()) {
+        m_animation.setStartValue(m_visualPosition);
+        m_animation.setEndValue(m_position);
+        m_animation.start();
+    } else {
+        setVisualPosition(m_position);
+    }
+    Q_EMIT positionChanged();
+}
+
+TriStateCorners TriStateSwitchKnobIcon::corners() const
+{
+    return m_corners;
+}
+
+void TriStateSwitchKnobIcon::setCorners(const TriStateCorners &corners)
+{
+    if (m_corners == corners) {
+        return;
+    }
+    m_corners = corners;
+    update();
+    Q_EMIT cornersChanged();
+}
+
+QColor TriStateSwitchKnobIcon::color() const
+{
+    return m_color;
+}
+
+void TriStateSwitchKnobIcon::setColor(const QColor &color)
+{
+    if (m_color == color) {
+        return;
+    }
+    m_color = color;
+    update();
+    Q_EMIT colorChanged();
+}
+
+qreal TriStateSwitchKnobIcon::lineWidth() const
+{
+    return m_lineWidth;
+}
+
+void TriStateSwitchKnobIcon::setLineWidth(qreal lineWidth)
+{
+    if (qFuzzyCompare(m_lineWidth, lineWidth)) {
+        return;
+    }
+    m_lineWidth = lineWidth;
+    update();
+    Q_EMIT lineWidthChanged();
+}
+
+bool TriStateSwitchKnobIcon::isAnimated() const
+{
+    return m_animated;
+}
+
+void TriStateSwitchKnobIcon::setAnimated(bool animated)
+{
+    if (m_animated == animated) {
+        return;
+    }
+    m_animated = animated;
+    if (!m_animated) {
+        m_animation.stop();
+        setVisualPosition(m_position);
+    }
+    Q_EMIT animatedChanged();
+}
+
+void TriStateSwitchKnobIcon::setVisualPosition(QPointF position)
+{
+    if (m_visualPosition == position) {
+        return;
+    }
+    m_visualPosition = position;
+    update();
+}
+
+QSGNode *TriStateSwitchKnobIcon::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+
+    const qreal w = width();
+    const qreal h = height();
+    if (w <= 0.0 || h <= 0.0) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    auto node = static_cast<QSGGeometryNode *>(oldNode);
+    if (!node) {
+        auto geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(),
+                                        NUM_PILLS * PILL_VERTICES, NUM_PILLS * PILL_INDICES, QSGGeometry::UnsignedShortType);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        quint16 *indices = geometry->indexDataAsUShort();
+        for (int p = 0; p < NUM_PILLS; p++) {
+            fillPillIndices(indices + p * PILL_INDICES, quint16(p * PILL_VERTICES));
+        }
+
+        node = new QSGGeometryNode;
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+    }
+
+    // weights of the states, i.e. how close the position is to each of them,
+    // measured along the perpendicular from the opposite edge of the triangle.
+    const qreal weightOfChecked = 1.0 - GeometryUtils::planarPosition(m_corners.unchecked(), m_corners.partiallyChecked(), m_corners.checked(), m_visualPosition).y();
+    const qreal weightOfPartiallyChecked = 1.0 - GeometryUtils::planarPosition(m_corners.unchecked(), m_corners.checked(), m_corners.partiallyChecked(), m_visualPosition).y();
+
+    const qreal t = std::min({m_lineWidth, w, h});
+    const qreal horizontalLength = GeometryUtils::lerp(w, t, weightOfPartiallyChecked);
+    const qreal verticalLength = GeometryUtils::lerp(t, h, weightOfChecked);
+
+    const Pill pills[NUM_PILLS] = {
+        // horizontal line for Unchecked minus sign & Checked plus sign,
+        // collapses into a middle dot for PartiallyChecked (...)
+        {QRectF((w - horizontalLength) / 2.0, (h - t) / 2.0, horizontalLength, t), 1.0},
+        // vertical line for Checked plus sign
+        // collapses into a middle dot for Unchecked & PartiallyChecked (...)
+        {QRectF((w - t) / 2.0, (h - verticalLength) / 2.0, t, verticalLength), 1.0},
+        // left and right dots for PartiallyChecked (...)
+        {QRectF(0.0, (h - t) / 2.0, t, t), weightOfPartiallyChecked},
+        {QRectF(w - t, (h - t) / 2.0, t, t), weightOfPartiallyChecked},
+    };
+
+    QSGGeometry::ColoredPoint2D *vertices = node->geometry()->vertexDataAsColoredPoint2D();
+    for (int p = 0; p < NUM_PILLS; p++) {
+        fillPillVertices(vertices + p * PILL_VERTICES, pills[p], m_color);
+    }
+    node->markDirty(QSGNode::DirtyGeometry);
+
+    return node;
+}
+
+void TriStateSwitchKnobIcon::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        update();
+    }
+}
+
+#include "moc_tristateswitchknobicon.cpp"
@@ -0,0 +1,69 @@
+#ifndef TRISTATESWITCHKNOBICON_H
+#define TRISTATESWITCHKNOBICON_H
+
+#include <QColor>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QVariantAnimation>
+
+#include "tristatecorners.h"
+
+// Icon of the knob: a minus sign for Unchecked, an ellipsis for PartiallyChecked
+// and a plus sign for Checked, morphing between them as the position moves
+// across the triangle of corners. Drawn as a single scene graph node.
+//
+// Changes of the position are eased natively while `animated` is true,
+// so following the switch does not evaluate any QML on animation ticks.
+class TriStateSwitchKnobIcon : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QPointF position READ position WRITE setPosition NOTIFY positionChanged FINAL)
+    Q_PROPERTY(TriStateCorners corners READ corners WRITE setCorners NOTIFY cornersChanged FINAL)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged FINAL)
+    Q_PROPERTY(qreal lineWidth READ lineWidth WRITE setLineWidth NOTIFY lineWidthChanged FINAL)
+    Q_PROPERTY(bool animated READ isAnimated WRITE setAnimated NOTIFY animatedChanged FINAL)
+    QML_ELEMENT
+
+public:
+    explicit TriStateSwitchKnobIcon(QQuickItem *parent = nullptr);
+
+    QPointF position() const;
+    void setPosition(QPointF position);
+
+    TriStateCorners corners() const;
+    void setCorners(const TriStateCorners &corners);
+
+    QColor color() const;
+    void setColor(const QColor &color);
+
+    qreal lineWidth() const;
+    void setLineWidth(qreal lineWidth);
+
+    bool isAnimated() const;
+    void setAnimated(bool animated);
+
+Q_SIGNALS:
+    void positionChanged();
+    void cornersChanged();
+    void colorChanged();
+    void lineWidthChanged();
+    void animatedChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private:
+    void setVisualPosition(QPointF position);
+
+    QPointF m_position;
+    // eased towards m_position, this is what gets drawn
+    QPointF m_visualPosition;
+    QVariantAnimation m_animation;
+    bool m_animated = true;
+    TriStateCorners m_corners{{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0}};
+    QColor m_color = Qt::black;
+    qreal m_lineWidth = 4.0;
+};
+
+#endif // TRISTATESWITCHKNOBICON_H